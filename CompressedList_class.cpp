@@ -0,0 +1,421 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/*
+ * List of integers with the same operations as LinkedList, but stored compressed.
+ *
+ * Every LinkedList node takes 16 bytes (plus what malloc adds) to store a 4 byte int. When the
+ * values are mostly increasing (e.g. IDs), neighbouring values are close to each other, so it is
+ * much cheaper to store just the difference (delta) from the previous value:
+ *
+ *  - Values are split into blocks of up to blockCapacity values.
+ *  - Block keeps its first and last value as they are, and the deltas between the consecutive
+ *    values as varints - 7 bits per byte, with the highest bit saying whether more bytes follow.
+ *    Deltas are zigzag encoded first (0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...), so that small
+ *    negative deltas take a single byte as well.
+ *
+ * A delta below 64 takes a single byte, so for increasing IDs that are close to each other that's
+ * ~1 byte per value instead of 16+.
+ *
+ * Appending only touches the last block. Removing values decodes, filters and re-encodes the
+ * blocks one by one, which is O(n) for the whole list - same as walking the LinkedList.
+ *
+ * NOTE: removeDuplicates() can't use a hash set of the values like LinkedList does - at 30+ bytes
+ * per distinct value it would take many times the memory the list itself saves. See there.
+ */
+class CompressedList {
+
+    static const int blockCapacity = 128;
+
+    struct Block {
+        int firstValue;
+        int lastValue;
+        int count;
+
+        /* Varint encoded deltas of the values after the first one. */
+        vector<uint8_t> deltas;
+    };
+
+    private:
+        vector<Block> blocks;
+        size_t length;
+
+        /* Whether the values are known to be in non-decreasing order, like in LinkedList. */
+        bool sorted;
+
+        /*
+         * Bounds of the values in the list. Removing values doesn't update them, so they may be
+         * wider than needed, but never narrower.
+         */
+        int minValue;
+        int maxValue;
+
+        static void appendDelta(Block& block, int64_t delta) {
+            uint64_t zigzag = (delta < 0) ? ((uint64_t)(-(delta + 1)) << 1) | 1 : (uint64_t)delta << 1;
+            while (zigzag >= 0x80) {
+                block.deltas.push_back((uint8_t)(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            block.deltas.push_back((uint8_t)zigzag);
+        }
+
+        /**
+         * Decodes all the values of the block into values, returns their count.
+         */
+        static int decodeBlock(const Block& block, int *values) {
+            values[0] = block.firstValue;
+
+            const uint8_t *bytes = block.deltas.data();
+            int64_t value = block.firstValue;
+            for (int i = 1; i < block.count; i++) {
+                uint64_t zigzag;
+                if (*bytes < 0x80) {
+                    // Fast path - single byte delta, which is the common case.
+                    zigzag = *bytes++;
+                } else {
+                    zigzag = 0;
+                    for (int shift = 0; ; shift += 7) {
+                        uint8_t byte = *bytes++;
+                        zigzag |= (uint64_t)(byte & 0x7F) << shift;
+                        if (byte < 0x80) break;
+                    }
+                }
+                int64_t delta = (zigzag & 1) ? -(int64_t)(zigzag >> 1) - 1 : (int64_t)(zigzag >> 1);
+                value += delta;
+                values[i] = (int)value;
+            }
+            return block.count;
+        }
+
+        /* Mixes the bits of the value, so that groups and hash table slots get filled evenly. */
+        static uint64_t hashValue(int value) {
+            uint64_t hash = (uint32_t)value;
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        static Block encodeBlock(const int *values, int count) {
+            Block block;
+            block.firstValue = values[0];
+            block.lastValue = values[count - 1];
+            block.count = count;
+            for (int i = 1; i < count; i++) {
+                appendDelta(block, (int64_t)values[i] - values[i - 1]);
+            }
+            block.deltas.shrink_to_fit();
+            return block;
+        }
+
+        /**
+         * Decodes every block, lets keep() decide which values stay, and re-encodes the
+         * kept ones into new blocks. Values keep their order.
+         */
+        template <typename KeepFunction>
+        void filter(KeepFunction keep) {
+            vector<Block> filteredBlocks;
+            int values[blockCapacity];
+            int keptValues[blockCapacity];
+
+            // NOTE: Kept values are gathered across blocks, so the blocks stay full even if
+            // a lot gets removed.
+            int keptCount = 0;
+            length = 0;
+            for (Block& block : blocks) {
+                int count = decodeBlock(block, values);
+                for (int i = 0; i < count; i++) {
+                    if (!keep(values[i])) continue;
+
+                    keptValues[keptCount++] = values[i];
+                    if (keptCount == blockCapacity) {
+                        filteredBlocks.push_back(encodeBlock(keptValues, keptCount));
+                        keptCount = 0;
+                    }
+                }
+                // Free the memory of the old block as we go.
+                vector<uint8_t>().swap(block.deltas);
+            }
+            if (keptCount > 0) filteredBlocks.push_back(encodeBlock(keptValues, keptCount));
+
+            blocks.swap(filteredBlocks);
+            for (Block& block : blocks) length += block.count;
+        }
+
+    public:
+        CompressedList() {
+            this->length = 0;
+            this->sorted = true;
+            this->minValue = 0;
+            this->maxValue = 0;
+        }
+
+        size_t size() {
+            return length;
+        }
+
+        bool isSorted() {
+            return sorted;
+        }
+
+        /**
+         * Appends given element to the end of the list.
+         */
+        void appendToEnd(int value) {
+            if (length == 0) {
+                minValue = maxValue = value;
+            } else {
+                if (value < blocks.back().lastValue) sorted = false;
+                minValue = min(minValue, value);
+                maxValue = max(maxValue, value);
+            }
+
+            if (blocks.empty() || blocks.back().count == blockCapacity) {
+                Block block;
+                block.firstValue = value;
+                block.lastValue = value;
+                block.count = 1;
+                blocks.push_back(block);
+            } else {
+                Block& block = blocks.back();
+                appendDelta(block, (int64_t)value - block.lastValue);
+                block.lastValue = value;
+                block.count++;
+            }
+            length++;
+        }
+
+        /**
+         * Removes all elements with the given value from the list.
+         */
+        void removeElement(int valueToRemove) {
+            // NOTE: Checking first, so the list isn't re-encoded if there is nothing to remove.
+            bool found = false;
+            forEach([&](int value) { if (value == valueToRemove) found = true; });
+            if (!found) return;
+
+            filter([&](int value) { return value != valueToRemove; });
+        }
+
+        /**
+         * Acts like unique, removing all duplicate elements from the list.
+         *
+         * In a sorted list duplicates are next to each other, so it's enough to compare every value
+         * with the previous one, without any extra memory.
+         *
+         * Otherwise, values that have been seen are marked, using at most ~1 byte per element (but
+         * at least 1MB), which is about what the list itself takes:
+         *  - If [minValue, maxValue] is dense enough (e.g. IDs), in a bitmap over that range.
+         *  - If not, in a flat hash table of ints. If the table for all the values wouldn't fit
+         *    in the memory limit, values are split into groups by their hash and every group is
+         *    deduplicated in its own pass through the list (a group that doesn't fit after all is
+         *    split further). The list is re-encoded only for the groups that do contain duplicates.
+         */
+        void removeDuplicates() {
+            if (length == 0) return;
+
+            if (sorted) {
+                bool first = true;
+                int previous = 0;
+                filter([&](int value) {
+                    bool keep = first || value != previous;
+                    first = false;
+                    previous = value;
+                    return keep;
+                });
+                return;
+            }
+
+            const size_t memoryLimit = max(length, (size_t)1 << 20);
+
+            uint64_t range = (int64_t)maxValue - minValue + 1;
+            if (range <= memoryLimit * 8) {
+                vector<uint64_t> seen (range / 64 + 1, 0);
+                filter([&](int value) {
+                    uint64_t offset = (int64_t)value - minValue;
+                    uint64_t bit = 1ULL << (offset % 64);
+                    if (seen[offset / 64] & bit) return false;
+                    seen[offset / 64] |= bit;
+                    return true;
+                });
+                return;
+            }
+
+            // Tables are a power of two big, with INT_MIN marking empty slots. Groups are sized to
+            // fill them half, but a table may get up to 3/4 full before the group has to be split.
+            size_t slotCount = 1;
+            while (slotCount * 2 * sizeof(int) <= memoryLimit) slotCount *= 2;
+            size_t groupCount = (length + slotCount / 2 - 1) / (slotCount / 2);
+
+            /*
+             * Values with hash % groupCount == index whose next depth bits of the hash are equal to
+             * bits. A group with more distinct values than fit into its table (hash values don't
+             * have to split evenly) is split in two by one more bit of the hash - distinct values
+             * have distinct hashes, so that always ends.
+             */
+            struct Group {
+                size_t index;
+                unsigned depth;
+                uint64_t bits;
+                size_t tableSize;
+            };
+
+            vector<Group> groups;
+            size_t expectedGroupSize = (length + groupCount - 1) / groupCount;
+            size_t initialTableSize = 2;
+            while (initialTableSize < 2 * expectedGroupSize && initialTableSize < slotCount) initialTableSize *= 2;
+            for (size_t group = groupCount; group-- > 0; ) {
+                groups.push_back({group, 0, 0, initialTableSize});
+            }
+
+            vector<int> slots;
+            size_t slotMask = 0;
+            size_t usedSlots = 0;
+            bool seenIntMin = false;
+            bool tableFull = false;
+
+            // Returns true if the value was already in the table, inserts it otherwise.
+            auto isSeen = [&](int value, uint64_t hash) {
+                if (value == INT_MIN) {
+                    bool wasSeen = seenIntMin;
+                    seenIntMin = true;
+                    return wasSeen;
+                }
+                for (size_t slot = (hash >> 32) & slotMask; ; slot = (slot + 1) & slotMask) {
+                    if (slots[slot] == value) return true;
+                    if (slots[slot] == INT_MIN) {
+                        // NOTE: Table never gets more than 3/4 full, so there always is an empty
+                        // slot to stop the probing at.
+                        if (4 * (usedSlots + 1) > 3 * (slotMask + 1)) {
+                            tableFull = true;
+                            return false;
+                        }
+                        slots[slot] = value;
+                        usedSlots++;
+                        return false;
+                    }
+                }
+            };
+
+            while (!groups.empty()) {
+                Group group = groups.back();
+                groups.pop_back();
+
+                auto isInGroup = [&](uint64_t hash) {
+                    if (hash % groupCount != group.index) return false;
+                    return group.depth == 0 || ((hash / groupCount) & ((1ULL << group.depth) - 1)) == group.bits;
+                };
+                auto resetTable = [&]() {
+                    slots.assign(group.tableSize, INT_MIN);
+                    slotMask = group.tableSize - 1;
+                    usedSlots = 0;
+                    seenIntMin = false;
+                    tableFull = false;
+                };
+
+                resetTable();
+                bool hasDuplicates = false;
+                forEach([&](int value) {
+                    uint64_t hash = hashValue(value);
+                    if (!tableFull && isInGroup(hash) && isSeen(value, hash)) hasDuplicates = true;
+                });
+
+                if (tableFull) {
+                    if (group.tableSize < slotCount) {
+                        group.tableSize = slotCount;
+                        groups.push_back(group);
+                    } else {
+                        groups.push_back({group.index, group.depth + 1, group.bits, slotCount});
+                        groups.push_back({group.index, group.depth + 1, group.bits | (1ULL << group.depth), slotCount});
+                    }
+                    continue;
+                }
+                if (!hasDuplicates) continue;
+
+                resetTable();
+                filter([&](int value) {
+                    uint64_t hash = hashValue(value);
+                    return !isInGroup(hash) || !isSeen(value, hash);
+                });
+            }
+        }
+
+        /**
+         * Calls f(value) for every element, in order.
+         */
+        template <typename Function>
+        void forEach(Function f) {
+            int values[blockCapacity];
+            for (const Block& block : blocks) {
+                int count = decodeBlock(block, values);
+                for (int i = 0; i < count; i++) f(values[i]);
+            }
+        }
+
+        /**
+         * Bytes of memory used by the list, including the unused capacity of the vectors.
+         */
+        size_t getMemoryUsage() {
+            size_t bytes = sizeof(*this) + blocks.capacity() * sizeof(Block);
+            for (const Block& block : blocks) bytes += block.deltas.capacity();
+            return bytes;
+        }
+
+        /**
+         * Prints elements of the list
+         */
+        void print() {
+            forEach([](int value) { cout << value << " -> "; });
+            cout << "NULL" << endl;
+        }
+};
+
+int main() {
+
+    CompressedList list = CompressedList();
+
+    list.appendToEnd(10);
+    list.appendToEnd(20);
+    list.appendToEnd(10);
+    list.appendToEnd(10);
+    list.appendToEnd(30);
+    list.appendToEnd(10);
+    list.appendToEnd(30);
+    list.appendToEnd(17);
+
+    list.print();
+
+    list.removeDuplicates();
+    list.print();
+
+    list.removeElement(20);
+    list.print();
+
+    // Memory footprint for a lot of mostly increasing IDs.
+    CompressedList ids = CompressedList();
+    int id = 1000000;
+    for (int i = 0; i < 1000000; i++) {
+        id += 1 + i % 37;
+        ids.appendToEnd(id);
+    }
+
+    long long sum = 0;
+    ids.forEach([&](int value) { sum += value; });
+
+    cout << ids.size() << " IDs take " << ids.getMemoryUsage() << " bytes ("
+         << (double)ids.getMemoryUsage() / ids.size() << " bytes per element), sum " << sum << endl;
+
+    // IDs are increasing, so this is a single pass without any extra memory.
+    ids.appendToEnd(id);
+    ids.removeDuplicates();
+    cout << "Without duplicates: " << ids.size() << " IDs" << endl;
+
+    return 0;
+}
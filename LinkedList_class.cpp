@@ -1,8 +1,33 @@
 #include <iostream>
+#include <fstream>
+#include <climits>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "instrumentation.h"
 
 using namespace std;
 
+/*
+ * Binary format used by LinkedList::serialize()/deserialize():
+ *
+ *      uint32 magic | uint32 version | uint64 count | int32 values[count]
+ *
+ * Everything is written in host byte order - files are meant to be reloaded
+ * on the same machine, not exchanged between different architectures.
+ */
+static const uint32_t listFileMagic = 0x4C435443; // "CTCL"
+static const uint32_t listFileVersion = 1;
+
+/* Number of values serialize()/deserialize() write/read at once. */
+static const size_t listReadChunkSize = 1 << 16;
+
 class LinkedList {
     
     /**
@@ -23,72 +48,529 @@ class LinkedList {
         /* Pointer to the first element of the linked list. */
         Node *head;
 
+        /*
+         * Whether the values are known to be in non-decreasing order. Sorted lists allow faster
+         * removeElement() and removeDuplicates(), and can be merged in linear time.
+         */
+        bool sorted;
+
+        /* Number of nodes in the list. */
+        size_t length;
+
+        /*
+         * Optional positional index - index[i] points to the node at position i * indexStride, so
+         * every node is less than indexStride steps away from some indexed node. With stride ~sqrt(n)
+         * that makes positional access O(sqrt(n)) for sqrt(n) extra pointers of memory.
+         */
+        bool indexEnabled;
+        vector<Node*> index;
+        size_t indexStride;
+        /* Stride asked for in enableIndex(), 0 means automatic (~sqrt(length)). */
+        size_t requestedIndexStride;
+
+        /*
+         * Optional value -> number of nodes with that value. Kept up to date by every method that
+         * adds or removes nodes, so contains() and count() are O(1) and removing a value that isn't
+         * in the list doesn't have to walk through it.
+         */
+        bool valueCountsEnabled;
+        unordered_map<int, size_t> valueCounts;
+
+        void countAdded(int value) {
+            if (valueCountsEnabled) valueCounts[value]++;
+        }
+
+        void countRemoved(int value) {
+            if (!valueCountsEnabled) return;
+
+            unordered_map<int, size_t>::iterator it = valueCounts.find(value);
+            if (it != valueCounts.end() && --it->second == 0) valueCounts.erase(it);
+        }
+
+        /* Mixes the bits of the value, so that hash table slots get filled evenly. */
+        static uint64_t hashValue(int value) {
+            uint64_t hash = (uint32_t)value;
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        size_t getAutoIndexStride() const {
+            return max((size_t)1, (size_t)sqrt((double)length));
+        }
+
+        /**
+         * Automatic stride is picked again (and the whole index rebuilt) only once it is off from
+         * sqrt(length) by more than 2x in either direction - otherwise almost every insert or remove
+         * would change it and rebuild the index from the start.
+         */
+        bool isAutoIndexStrideOff() const {
+            return requestedIndexStride == 0
+                   && (4 * indexStride * indexStride < length || indexStride > 2 * getAutoIndexStride());
+        }
+
+        /**
+         * Brings the index up to date after the nodes at the given position and after it have
+         * changed. Indexed nodes before that position are still at the same place, so only the
+         * rest of the list has to be walked through.
+         */
+        void rebuildIndexFrom(size_t position) {
+            if (!indexEnabled) return;
+
+            if (isAutoIndexStrideOff()) {
+                indexStride = getAutoIndexStride();
+                position = 0;
+            }
+
+            // Keep the entries that point before the position.
+            size_t validEntries = min(index.size(), (position + indexStride - 1) / indexStride);
+            index.resize(validEntries);
+
+            Node *currNode = validEntries > 0 ? index.back() : head;
+            size_t currPosition = validEntries > 0 ? (validEntries - 1) * indexStride : 0;
+            for (; currNode != NULL; currNode = currNode->next, currPosition++) {
+                if (currPosition % indexStride == 0 && currPosition / indexStride >= validEntries) {
+                    index.push_back(currNode);
+                }
+            }
+        }
+
+        /**
+         * Merges two sorted chains of nodes into one and returns its first node.
+         * Equal values keep their order - nodes of a come before nodes of b.
+         */
+        static Node* merge(Node *a, Node *b) {
+            Node dummy (0);
+            Node *tail = &dummy;
+            while (a != NULL && b != NULL) {
+                if (b->value < a->value) {
+                    tail->next = b;
+                    b = b->next;
+                } else {
+                    tail->next = a;
+                    a = a->next;
+                }
+                tail = tail->next;
+            }
+            tail->next = (a != NULL) ? a : b;
+
+            return dummy.next;
+        }
+
     public:
         /**
          * Initializes empty linked lists.
          */
         LinkedList() {
             this->head = NULL;
+            this->sorted = true;
+            this->length = 0;
+
+            this->indexEnabled = false;
+            this->indexStride = 1;
+            this->requestedIndexStride = 0;
+
+            this->valueCountsEnabled = false;
+        }
+
+        bool isSorted() {
+            return sorted;
+        }
+
+        size_t size() {
+            return length;
+        }
+
+        /**
+         * Starts maintaining the positional index. Stride is the distance between indexed nodes -
+         * bigger stride means less memory but slower access. With 0, stride is kept at ~sqrt(size).
+         */
+        void enableIndex(size_t stride = 0) {
+            indexEnabled = true;
+            requestedIndexStride = stride;
+            indexStride = max((size_t)1, stride);
+
+            index.clear();
+            rebuildIndexFrom(0);
+        }
+
+        void disableIndex() {
+            indexEnabled = false;
+            index.clear();
+            index.shrink_to_fit();
+        }
+
+        size_t getIndexMemoryUsage() {
+            return index.capacity() * sizeof(Node*);
+        }
+
+        /**
+         * Starts keeping count of every value in the list - O(n) to build it once, O(1) to keep it
+         * up to date on every added or removed node after that.
+         */
+        void enableValueCounts() {
+            valueCountsEnabled = true;
+            valueCounts.clear();
+            for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+                valueCounts[currNode->value]++;
+            }
+        }
+
+        void disableValueCounts() {
+            valueCountsEnabled = false;
+            unordered_map<int, size_t>().swap(valueCounts);
+        }
+
+        /**
+         * Number of nodes with the given value.
+         *
+         * Time complexity: O(1) with value counts, O(n) without them.
+         */
+        size_t count(int value) {
+            if (valueCountsEnabled) {
+                unordered_map<int, size_t>::iterator it = valueCounts.find(value);
+                return it != valueCounts.end() ? it->second : 0;
+            }
+
+            size_t result = 0;
+            for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+                if (currNode->value == value) result++;
+            }
+            return result;
+        }
+
+        bool contains(int value) {
+            if (valueCountsEnabled) return valueCounts.find(value) != valueCounts.end();
+
+            for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+                if (currNode->value == value) return true;
+            }
+            return false;
+        }
+
+        /**
+         * Gets the value at the given position (0 is the head). Returns false if there is no such position.
+         *
+         * Time complexity: O(stride) with the index, O(position) without it.
+         */
+        bool getAt(size_t position, int& value) {
+            if (position >= length) return false;
+
+            Node *currNode = head;
+            size_t stepsLeft = position;
+            if (indexEnabled && !index.empty()) {
+                currNode = index[min(position / indexStride, index.size() - 1)];
+                stepsLeft = position - min(position / indexStride, index.size() - 1) * indexStride;
+            }
+            for (; stepsLeft > 0; stepsLeft--) {
+                currNode = currNode->next;
+            }
+            value = currNode->value;
+            return true;
+        }
+
+        /**
+         * Gets the value of the k-th node from the end - k = 1 is the last node.
+         * Returns false if there is no such node.
+         */
+        bool getKthFromEnd(size_t k, int& value) {
+            if (k == 0 || k > length) return false;
+            return getAt(length - k, value);
         }
         
         /**
          * Appends given element to the end of the list.
          */
         void appendToEnd(int value) {
+            INSTRUMENT_ROUTINE("LinkedList::appendToEnd", sizeof(int));
+
             if (head == NULL) {
                 head = new Node(value);
                 head->next = NULL;
 
+                length = 1;
+                countAdded(value);
+                rebuildIndexFrom(0);
                 return;
             }
 
-            Node *currNode = head;
+            // With the index, the last indexed node is already close to the end.
+            Node *currNode = (indexEnabled && !index.empty()) ? index.back() : head;
 
             // Get to the last node.
             while (currNode->next != NULL) {
                 currNode = currNode->next;
             }
 
+            if (value < currNode->value) sorted = false;
+
             // Create new node.
             Node *newNode = new Node(value);
             newNode->next = NULL;
 
             // Append it to the the last node.
             currNode->next = newNode;
+            length++;
+            countAdded(value);
+
+            if (indexEnabled) {
+                if ((length - 1) % indexStride == 0) index.push_back(newNode);
+
+                if (isAutoIndexStrideOff()) rebuildIndexFrom(0);
+            }
+        }
+
+        /**
+         * Inserts the value so that the list stays sorted. If the list isn't sorted, it is sorted first.
+         */
+        void insertSorted(int value) {
+            if (!sorted) sort();
+
+            Node *newNode = new Node(value);
+            length++;
+            countAdded(value);
+            if (head == NULL || value < head->value) {
+                newNode->next = head;
+                head = newNode;
+                rebuildIndexFrom(0);
+                return;
+            }
+
+            // Insert after the last node that is not bigger than value.
+            Node *currNode = head;
+            size_t position = 1;
+            while (currNode->next != NULL && currNode->next->value <= value) {
+                currNode = currNode->next;
+                position++;
+            }
+            newNode->next = currNode->next;
+            currNode->next = newNode;
+
+            rebuildIndexFrom(position);
         }
 
         /**
          * Removes all nodes with the given value from the list.
          */
         void removeElement(int valueToRemove) {
+            INSTRUMENT_ROUTINE("LinkedList::removeElement", length * sizeof(int));
+
+            // Nothing to remove - no need to walk through the list.
+            if (valueCountsEnabled && valueCounts.find(valueToRemove) == valueCounts.end()) return;
+
+            if (sorted) {
+                removeElementSorted(valueToRemove);
+                return;
+            }
+
+            // Position of the first removed node, the index is correct up to there.
+            size_t firstRemoved = length;
+
             // Remove consecutives at the beginning.
             while (head != NULL && head->value == valueToRemove) {
                 Node *tmp = head;
                 head = head->next;
                 delete tmp;
+
+                firstRemoved = 0;
+                length--;
             }
 
             // Here the list is either empty or head is pointing at the node 
             // different from valueToRemove.
             Node *currNode = head;
+            size_t position = 0;
             while (currNode != NULL) {
                 if (currNode->next != NULL && currNode->next->value == valueToRemove) {
                     Node *tmp = currNode->next;
                     currNode->next = currNode->next->next;
                     delete tmp;
+
+                    firstRemoved = min(firstRemoved, position + 1);
+                    length--;
                 } else {
                     // Move forward only if the next node doesn't have to be deleted.
                     currNode = currNode->next;
+                    position++;
                 }
             }
+
+            if (valueCountsEnabled) valueCounts.erase(valueToRemove);
+            rebuildIndexFrom(firstRemoved);
+        }
+
+        /**
+         * Sorted version of removeElement() - nodes to remove are all next to each other, so
+         * we can stop as soon as we get past them.
+         */
+        void removeElementSorted(int valueToRemove) {
+            // Find the last node smaller than valueToRemove (NULL if there is none).
+            Node *prevNode = NULL;
+            Node *currNode = head;
+            size_t position = 0;
+            while (currNode != NULL && currNode->value < valueToRemove) {
+                prevNode = currNode;
+                currNode = currNode->next;
+                position++;
+            }
+
+            size_t removedCount = 0;
+            while (currNode != NULL && currNode->value == valueToRemove) {
+                Node *tmp = currNode;
+                currNode = currNode->next;
+                delete tmp;
+                removedCount++;
+            }
+            if (removedCount == 0) return;
+
+            if (prevNode == NULL) {
+                head = currNode;
+            } else {
+                prevNode->next = currNode;
+            }
+            length -= removedCount;
+            if (valueCountsEnabled) valueCounts.erase(valueToRemove);
+            rebuildIndexFrom(position);
+        }
+
+        /**
+         * Removes all nodes with any of the given values, in a single pass through the list.
+         *
+         * NOTE: Membership isn't tested in the hash set itself - that means following a bucket chain
+         * of separately allocated nodes for every node of the list. When the values are close to
+         * each other (e.g. IDs), they are put into a bitmap over their range - a shift and a mask.
+         * Otherwise, into a flat open-addressing table of ints, where a lookup usually touches a
+         * single cache line.
+         *
+         * Time complexity: O(n + k) for n nodes and k values to remove.
+         */
+        void removeElements(const unordered_set<int>& valuesToRemove) {
+            INSTRUMENT_ROUTINE("LinkedList::removeElements", length * sizeof(int));
+
+            if (head == NULL || valuesToRemove.empty()) return;
+
+            if (valueCountsEnabled) {
+                bool anyPresent = false;
+                for (int value : valuesToRemove) {
+                    if (valueCounts.find(value) != valueCounts.end()) {
+                        anyPresent = true;
+                        break;
+                    }
+                }
+                if (!anyPresent) return;
+            }
+
+            int64_t minValue = *min_element(valuesToRemove.begin(), valuesToRemove.end());
+            int64_t maxValue = *max_element(valuesToRemove.begin(), valuesToRemove.end());
+            uint64_t range = maxValue - minValue + 1;
+
+            // Bitmap only if it isn't bigger than the hash set itself (~64 bits per value).
+            vector<uint64_t> bitmap;
+            bool useBitmap = range <= 64 * (uint64_t)valuesToRemove.size();
+            if (useBitmap) {
+                bitmap.assign(range / 64 + 1, 0);
+                for (int value : valuesToRemove) {
+                    uint64_t offset = value - minValue;
+                    bitmap[offset / 64] |= 1ULL << (offset % 64);
+                }
+            }
+
+            // Table is a power of two big and at most half full, with INT_MIN marking empty slots.
+            vector<int> slots;
+            size_t slotMask = 0;
+            bool removeIntMin = false;
+            if (!useBitmap) {
+                size_t slotCount = 2;
+                while (slotCount < 2 * valuesToRemove.size()) slotCount *= 2;
+                slots.assign(slotCount, INT_MIN);
+                slotMask = slotCount - 1;
+
+                for (int value : valuesToRemove) {
+                    if (value == INT_MIN) {
+                        removeIntMin = true;
+                        continue;
+                    }
+                    size_t slot = hashValue(value) & slotMask;
+                    while (slots[slot] != INT_MIN) slot = (slot + 1) & slotMask;
+                    slots[slot] = value;
+                }
+            }
+
+            auto isInTable = [&](int value) {
+                if (value == INT_MIN) return removeIntMin;
+                for (size_t slot = hashValue(value) & slotMask; slots[slot] != INT_MIN; slot = (slot + 1) & slotMask) {
+                    if (slots[slot] == value) return true;
+                }
+                return false;
+            };
+
+            // Position of the first removed node, the index is correct up to there.
+            size_t firstRemoved = length;
+            size_t position = 0;
+
+            Node dummy (0);
+            dummy.next = head;
+            Node *prevNode = &dummy;
+            while (prevNode->next != NULL) {
+                int value = prevNode->next->value;
+
+                bool remove;
+                if (useBitmap) {
+                    uint64_t offset = (int64_t)value - minValue;
+                    remove = offset < range && (bitmap[offset / 64] >> (offset % 64)) & 1;
+                } else {
+                    remove = isInTable(value);
+                }
+
+                if (remove) {
+                    Node *tmp = prevNode->next;
+                    prevNode->next = tmp->next;
+                    delete tmp;
+
+                    firstRemoved = min(firstRemoved, position);
+                    length--;
+                    countRemoved(value);
+                } else {
+                    prevNode = prevNode->next;
+                    position++;
+                }
+            }
+            head = dummy.next;
+
+            rebuildIndexFrom(firstRemoved);
         }
 
         /**
          * Acts like unique, removing all duplicate elements from the list.
+         *
+         * NOTE: In a sorted list duplicates are next to each other, so there we don't need the map -
+         * it's enough to compare every node with the next one.
          */
         void removeDuplicates() {
+            INSTRUMENT_ROUTINE("LinkedList::removeDuplicates", length * sizeof(int));
+
             if (head == NULL) return;
 
+            if (sorted) {
+                Node *currNode = head;
+                while (currNode->next != NULL) {
+                    if (currNode->next->value == currNode->value) {
+                        Node *tmp = currNode->next;
+                        currNode->next = tmp->next;
+                        delete tmp;
+                        length--;
+                        countRemoved(currNode->value);
+                    } else {
+                        currNode = currNode->next;
+                    }
+                }
+                rebuildIndexFrom(0);
+                return;
+            }
+
             map<int, bool> presentElements;
             presentElements[head->value] = true;
 
@@ -98,13 +580,178 @@ class LinkedList {
                     // Encountered duplicate - delete it.
                     Node *tmp = currNode->next;
                     currNode->next = currNode->next->next;
+                    countRemoved(tmp->value);
                     delete tmp;
+                    length--;
                 } else {
                     // Not a duplicate, marked as present and move on.
                     presentElements[currNode->next->value] = true;
                     currNode = currNode->next;
                 }
             }
+            rebuildIndexFrom(0);
+        }
+
+        /**
+         * Sorts the list in non-decreasing order, keeping the order of equal values.
+         *
+         * Bottom-up merge sort: nodes are taken from the list one by one and every one of them
+         * starts as a sorted run of length 1. runs[i] holds a sorted run of 2^i nodes - when a new
+         * run of that length comes, the two are merged into a run of 2^(i+1) nodes, which goes on
+         * to runs[i+1], and so on (just like adding 1 to a binary number). At the end, all the runs
+         * left are merged together.
+         *
+         * Nodes are only relinked - nothing is allocated or copied. Small runs are merged right
+         * after their nodes were visited, while they're still in the cache, which makes this a lot
+         * faster than merging runs of 1, then 2, then 4... across the whole list.
+         *
+         * Time complexity: O(n log n)
+         * Space complexity: O(1) - 64 run pointers are enough for any list that fits in memory.
+         */
+        void sort() {
+            INSTRUMENT_ROUTINE("LinkedList::sort", length * sizeof(int));
+
+            Node *runs[64] = {};
+            while (head != NULL) {
+                Node *run = head;
+                head = head->next;
+                run->next = NULL;
+
+                // NOTE: Runs in runs[] hold earlier nodes, so they go first to keep the sort stable.
+                int i = 0;
+                for (; runs[i] != NULL; i++) {
+                    run = merge(runs[i], run);
+                    runs[i] = NULL;
+                }
+                runs[i] = run;
+            }
+
+            for (int i = 0; i < 64; i++) {
+                if (runs[i] != NULL) head = merge(runs[i], head);
+            }
+            sorted = true;
+            rebuildIndexFrom(0);
+        }
+
+        /**
+         * Merges all the nodes of the other list into this one, keeping it sorted. Lists that
+         * aren't sorted are sorted first. Other list is left empty.
+         *
+         * Time complexity: O(n + m) for sorted lists.
+         */
+        void mergeSorted(LinkedList& other) {
+            if (&other == this) return;
+            if (!sorted) sort();
+            if (!other.sorted) other.sort();
+
+            if (valueCountsEnabled) {
+                for (Node *currNode = other.head; currNode != NULL; currNode = currNode->next) {
+                    valueCounts[currNode->value]++;
+                }
+            }
+
+            head = merge(head, other.head);
+            length += other.length;
+            rebuildIndexFrom(0);
+
+            other.head = NULL;
+            other.length = 0;
+            other.valueCounts.clear();
+            other.rebuildIndexFrom(0);
+        }
+
+        /**
+         * Deletes all nodes, leaving the list empty.
+         */
+        void clear() {
+            while (head != NULL) {
+                Node *tmp = head;
+                head = head->next;
+                delete tmp;
+            }
+            sorted = true;
+            length = 0;
+            valueCounts.clear();
+            rebuildIndexFrom(0);
+        }
+
+        /**
+         * Writes the list to the given stream in the binary format described above.
+         */
+        void serialize(ostream& out) {
+            uint64_t count = length;
+            out.write((const char*)&listFileMagic, sizeof(listFileMagic));
+            out.write((const char*)&listFileVersion, sizeof(listFileVersion));
+            out.write((const char*)&count, sizeof(count));
+
+            // Values go out through a small buffer, so a big list isn't copied as a whole.
+            vector<int32_t> values;
+            values.reserve(min(length, listReadChunkSize));
+            for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+                values.push_back(currNode->value);
+                if (values.size() == listReadChunkSize || currNode->next == NULL) {
+                    out.write((const char*)values.data(), values.size() * sizeof(int32_t));
+                    values.clear();
+                }
+            }
+        }
+
+        /**
+         * Replaces the content of the list with the one read from the given stream.
+         * Returns false (and leaves the list empty) if the stream doesn't hold a valid list.
+         */
+        bool deserialize(istream& in) {
+            clear();
+
+            uint32_t magic = 0, version = 0;
+            uint64_t count = 0;
+            in.read((char*)&magic, sizeof(magic));
+            in.read((char*)&version, sizeof(version));
+            in.read((char*)&count, sizeof(count));
+            if (!in || magic != listFileMagic || version != listFileVersion) return false;
+
+            // NOTE: Count comes from the file, so it can't be trusted with an allocation up front -
+            // values are read in bounded chunks, and a short read means the file is broken.
+            vector<int32_t> values;
+            Node *tail = NULL;
+            for (uint64_t valuesLeft = count; valuesLeft > 0; ) {
+                size_t chunkCount = (size_t)min(valuesLeft, (uint64_t)listReadChunkSize);
+                values.resize(chunkCount);
+                in.read((char*)values.data(), chunkCount * sizeof(int32_t));
+                if (!in) {
+                    clear();
+                    return false;
+                }
+                valuesLeft -= chunkCount;
+
+                // NOTE: We keep track of the tail here - going through appendToEnd() would
+                // make loading O(n^2).
+                for (int32_t& value : values) {
+                    Node *newNode = new Node(value);
+                    if (tail == NULL) {
+                        head = newNode;
+                    } else {
+                        if (value < tail->value) sorted = false;
+                        tail->next = newNode;
+                    }
+                    tail = newNode;
+                    countAdded(value);
+                }
+            }
+            length = count;
+            rebuildIndexFrom(0);
+            return true;
+        }
+
+        bool saveToFile(const string& path) {
+            ofstream out(path, ios::binary);
+            serialize(out);
+            return (bool)out;
+        }
+
+        bool loadFromFile(const string& path) {
+            ifstream in(path, ios::binary);
+            return deserialize(in);
         }
 
         /**
@@ -160,5 +807,52 @@ int main() {
     list.removeDuplicates();
     list.print();
 
+    // Round trip through the binary format.
+    stringstream buffer;
+    list.serialize(buffer);
+
+    LinkedList loadedList = LinkedList();
+    cout << "Loaded from binary: " << (loadedList.deserialize(buffer) ? "ok" : "failed") << endl;
+    loadedList.print();
+
+    // Sorting and merging sorted lists.
+    LinkedList unsortedList = LinkedList();
+    unsortedList.appendToEnd(5);
+    unsortedList.appendToEnd(3);
+    unsortedList.appendToEnd(8);
+    unsortedList.appendToEnd(3);
+    unsortedList.appendToEnd(1);
+
+    unsortedList.sort();
+    cout << "Sorted: ";
+    unsortedList.print();
+
+    unsortedList.mergeSorted(loadedList);
+    cout << "Merged with the loaded list: ";
+    unsortedList.print();
+
+    unsortedList.removeDuplicates();
+    unsortedList.removeElement(17);
+    cout << "Without duplicates and 17: ";
+    unsortedList.print();
+
+    // Positional access through the index.
+    unsortedList.enableIndex();
+    int value;
+    if (unsortedList.getAt(2, value)) cout << "Element at position 2: " << value << endl;
+    if (unsortedList.getKthFromEnd(3, value)) cout << "3rd from end: " << value << endl;
+
+    // Removing many values at once, with value counts kept up to date.
+    unsortedList.enableValueCounts();
+    cout << "Count of 10: " << unsortedList.count(10) << ", contains 4: " << unsortedList.contains(4) << endl;
+    unsortedList.removeElements({1, 5, 10, 42});
+    cout << "Without 1, 5, 10 and 42: ";
+    unsortedList.print();
+    cout << "Contains 10: " << unsortedList.contains(10) << endl;
+
+    // Only writes something if compiled with -DINSTRUMENT.
+    writeInstrumentationJson("LinkedList_class_instrumentation.json");
+    writeInstrumentationPrometheus("LinkedList_class_instrumentation.prom");
+
     return 0;
 }
@@ -0,0 +1,360 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/*
+ * Instrumentation of the hot routines.
+ *
+ * Put INSTRUMENT_ROUTINE("name", bytesProcessed) at the beginning of a function and for every
+ * call it records:
+ *  - call count and number of bytes processed,
+ *  - latency, in a histogram with 4 sub-buckets per power of two of nanoseconds (so every
+ *    recorded latency is accurate to within 25%, no matter how big it is), and the exact maximum,
+ *  - number of heap allocations made during the call (including the nested calls).
+ *
+ * It is compiled in only with -DINSTRUMENT. Otherwise INSTRUMENT_ROUTINE expands to nothing and
+ * the export functions don't write anything, so there is no cost at all.
+ *
+ * Every thread counts into its own counters, so recording never waits on a lock. Counters of all
+ * the threads are summed up only when the stats are exported.
+ *
+ * NOTE: With INSTRUMENT defined this header replaces global operator new to count allocations,
+ * so it must be included in only one source file of a program.
+ */
+
+#include <string>
+
+#ifdef INSTRUMENT
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+static const int maxInstrumentedRoutines = 32;
+static const int latencyBucketCount = 48 * 4;
+
+/* Number of counters in the flat form (see addRoutineStats()) before the latency buckets. */
+static const int flatCounterCount = 5;
+
+struct RoutineStats {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> totalNanos;
+    std::atomic<uint64_t> maxNanos;
+    std::atomic<uint64_t> latencyBuckets[latencyBucketCount];
+};
+
+/*
+ * Counters of a single thread.
+ *
+ * NOTE: Only the owning thread writes them, so a plain load + store is enough - atomics are here
+ * just so that exporting can read them while the thread is running.
+ */
+struct ThreadInstrumentation {
+    RoutineStats routines[maxInstrumentedRoutines];
+
+    ThreadInstrumentation();
+    ~ThreadInstrumentation();
+};
+
+struct InstrumentationRegistry {
+    std::mutex lock;
+    std::vector<std::string> routineNames;
+    std::vector<ThreadInstrumentation*> liveThreads;
+
+    /* Counters of the threads that have already finished. */
+    uint64_t retired[maxInstrumentedRoutines][flatCounterCount + latencyBucketCount] = {};
+};
+
+static InstrumentationRegistry& getInstrumentationRegistry () {
+    static InstrumentationRegistry registry;
+    return registry;
+}
+
+static void incrementCounter (std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+/*
+ * Adds counters of one routine to a flat array: calls, bytes, allocations, total nanos,
+ * max nanos and then the latency buckets.
+ */
+static void addRoutineStats (const RoutineStats& stats, uint64_t* flat) {
+    flat[0] += stats.calls.load(std::memory_order_relaxed);
+    flat[1] += stats.bytes.load(std::memory_order_relaxed);
+    flat[2] += stats.allocations.load(std::memory_order_relaxed);
+    flat[3] += stats.totalNanos.load(std::memory_order_relaxed);
+    flat[4] = std::max(flat[4], (uint64_t)stats.maxNanos.load(std::memory_order_relaxed));
+    for (int b = 0; b < latencyBucketCount; b++) {
+        flat[flatCounterCount + b] += stats.latencyBuckets[b].load(std::memory_order_relaxed);
+    }
+}
+
+ThreadInstrumentation::ThreadInstrumentation () : routines() {
+    InstrumentationRegistry& registry = getInstrumentationRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.liveThreads.push_back(this);
+}
+
+ThreadInstrumentation::~ThreadInstrumentation () {
+    InstrumentationRegistry& registry = getInstrumentationRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    for (int r = 0; r < maxInstrumentedRoutines; r++) {
+        addRoutineStats(routines[r], registry.retired[r]);
+    }
+    for (size_t i = 0; i < registry.liveThreads.size(); i++) {
+        if (registry.liveThreads[i] == this) {
+            registry.liveThreads.erase(registry.liveThreads.begin() + i);
+            break;
+        }
+    }
+}
+
+static ThreadInstrumentation& getThreadInstrumentation () {
+    static thread_local ThreadInstrumentation instrumentation;
+    return instrumentation;
+}
+
+/*
+ * Counting allocations. This is a plain thread_local (not a part of ThreadInstrumentation), so
+ * that allocations made while ThreadInstrumentation itself is being created don't recurse into it.
+ */
+static thread_local uint64_t threadAllocationCount = 0;
+
+void* operator new (size_t size) {
+    threadAllocationCount++;
+    void *memory = std::malloc(size > 0 ? size : 1);
+    if (memory == NULL) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new (size_t size, const std::nothrow_t&) noexcept {
+    threadAllocationCount++;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+/*
+ * Aligned versions, used e.g. by Matrix storage.
+ * aligned_alloc() needs size to be a multiple of alignment.
+ */
+void* operator new (size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    threadAllocationCount++;
+    size_t alignmentBytes = (size_t)alignment;
+    size_t roundedSize = (std::max(size, (size_t)1) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    return std::aligned_alloc(alignmentBytes, roundedSize);
+}
+
+void* operator new (size_t size, std::align_val_t alignment) {
+    void *memory = operator new(size, alignment, std::nothrow);
+    if (memory == NULL) throw std::bad_alloc();
+    return memory;
+}
+
+// NOTE: GCC can't see that new and delete above are a matching pair.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete (void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete (void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete (void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete (void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+#pragma GCC diagnostic pop
+
+static int registerInstrumentedRoutine (const char* name) {
+    InstrumentationRegistry& registry = getInstrumentationRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    for (size_t i = 0; i < registry.routineNames.size(); i++) {
+        if (registry.routineNames[i] == name) return i;
+    }
+    // Routines over the limit are not recorded.
+    if ((int)registry.routineNames.size() == maxInstrumentedRoutines) return -1;
+
+    registry.routineNames.push_back(name);
+    return registry.routineNames.size() - 1;
+}
+
+/*
+ * Bucket index = 4 * (position of the highest set bit) + (the next two bits).
+ */
+static int getLatencyBucket (uint64_t nanos) {
+    if (nanos < 4) return nanos;
+
+    int highestBit = 63 - __builtin_clzll(nanos);
+    int bucket = 4 * (highestBit - 1) + ((nanos >> (highestBit - 2)) & 3);
+    return bucket < latencyBucketCount ? bucket : latencyBucketCount - 1;
+}
+
+/* Smallest latency that falls into the given bucket. */
+static uint64_t getLatencyBucketStart (int bucket) {
+    if (bucket < 4) return bucket;
+
+    int highestBit = bucket / 4 + 1;
+    return (1ULL << highestBit) | ((uint64_t)(bucket % 4) << (highestBit - 2));
+}
+
+/*
+ * Records one call of a routine - from construction to destruction.
+ */
+class InstrumentedRoutineScope {
+    private:
+        int routineId;
+        uint64_t bytes;
+        uint64_t allocationsAtStart;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        InstrumentedRoutineScope (int routineId, uint64_t bytes)
+            : routineId(routineId), bytes(bytes), allocationsAtStart(threadAllocationCount),
+              start(std::chrono::steady_clock::now()) {}
+
+        ~InstrumentedRoutineScope () {
+            uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (routineId < 0) return;
+
+            // NOTE: Taken before getThreadInstrumentation(), which allocates on its first call.
+            uint64_t allocations = threadAllocationCount - allocationsAtStart;
+
+            RoutineStats& stats = getThreadInstrumentation().routines[routineId];
+            incrementCounter(stats.calls, 1);
+            incrementCounter(stats.bytes, bytes);
+            incrementCounter(stats.allocations, allocations);
+            incrementCounter(stats.totalNanos, nanos);
+            if (nanos > stats.maxNanos.load(std::memory_order_relaxed)) {
+                stats.maxNanos.store(nanos, std::memory_order_relaxed);
+            }
+            incrementCounter(stats.latencyBuckets[getLatencyBucket(nanos)], 1);
+        }
+};
+
+#define INSTRUMENT_ROUTINE(name, bytesProcessed) \
+    static const int instrumentedRoutineId = registerInstrumentedRoutine(name); \
+    InstrumentedRoutineScope instrumentedRoutineScope (instrumentedRoutineId, (bytesProcessed))
+
+/*
+ * Sums up the counters of all the threads. Returns routine names, and for each of them the
+ * flat counters as described in addRoutineStats().
+ */
+static std::vector<std::vector<uint64_t>> collectInstrumentation (std::vector<std::string>& names) {
+    InstrumentationRegistry& registry = getInstrumentationRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    names = registry.routineNames;
+    std::vector<std::vector<uint64_t>> merged (names.size());
+    for (size_t r = 0; r < names.size(); r++) {
+        merged[r].assign(registry.retired[r], registry.retired[r] + flatCounterCount + latencyBucketCount);
+        for (ThreadInstrumentation *thread : registry.liveThreads) {
+            addRoutineStats(thread->routines[r], merged[r].data());
+        }
+    }
+    return merged;
+}
+
+/*
+ * Latency that the given fraction of the calls doesn't exceed. It's the upper bound of the bucket
+ * the percentile falls into (same as the le of that bucket in Prometheus), so it over-reports by
+ * less than 25% rather than under-reports. Never more than the exact maximum, though.
+ */
+static uint64_t getLatencyPercentile (const std::vector<uint64_t>& flat, double fraction) {
+    uint64_t calls = flat[0];
+    uint64_t seen = 0;
+    for (int b = 0; b < latencyBucketCount; b++) {
+        seen += flat[flatCounterCount + b];
+        if (calls > 0 && seen >= fraction * calls) return std::min(getLatencyBucketStart(b + 1) - 1, flat[4]);
+    }
+    return 0;
+}
+
+static bool writeInstrumentationJson (const std::string& path) {
+    std::vector<std::string> names;
+    std::vector<std::vector<uint64_t>> merged = collectInstrumentation(names);
+
+    std::ofstream out(path);
+    out << "{" << std::endl;
+    for (size_t r = 0; r < names.size(); r++) {
+        const std::vector<uint64_t>& flat = merged[r];
+        out << "  \"" << names[r] << "\": {"
+            << "\"calls\": " << flat[0]
+            << ", \"bytes\": " << flat[1]
+            << ", \"allocations\": " << flat[2]
+            << ", \"total_ns\": " << flat[3]
+            << ", \"p50_ns\": " << getLatencyPercentile(flat, 0.5)
+            << ", \"p99_ns\": " << getLatencyPercentile(flat, 0.99)
+            << ", \"max_ns\": " << flat[4]
+            << "}" << (r + 1 < names.size() ? "," : "") << std::endl;
+    }
+    out << "}" << std::endl;
+    return (bool)out;
+}
+
+static bool writeInstrumentationPrometheus (const std::string& path) {
+    std::vector<std::string> names;
+    std::vector<std::vector<uint64_t>> merged = collectInstrumentation(names);
+
+    std::ofstream out(path);
+
+    // NOTE: All the lines of one metric have to come together, so it's metrics in the outer loop
+    // and routines in the inner one.
+    const char* counterNames[3] = {"routine_calls_total", "routine_bytes_total", "routine_allocations_total"};
+    for (int counter = 0; counter < 3; counter++) {
+        out << "# TYPE " << counterNames[counter] << " counter" << std::endl;
+        for (size_t r = 0; r < names.size(); r++) {
+            out << counterNames[counter] << "{routine=\"" << names[r] << "\"} " << merged[r][counter] << std::endl;
+        }
+    }
+
+    out << "# TYPE routine_latency_ns histogram" << std::endl;
+    for (size_t r = 0; r < names.size(); r++) {
+        const std::vector<uint64_t>& flat = merged[r];
+        std::string label = "{routine=\"" + names[r] + "\"}";
+
+        // Buckets are cumulative, only the non-empty ones are written.
+        uint64_t cumulative = 0;
+        for (int b = 0; b < latencyBucketCount; b++) {
+            if (flat[flatCounterCount + b] == 0) continue;
+            cumulative += flat[flatCounterCount + b];
+            out << "routine_latency_ns_bucket{routine=\"" << names[r] << "\",le=\""
+                << getLatencyBucketStart(b + 1) - 1 << "\"} " << cumulative << std::endl;
+        }
+        out << "routine_latency_ns_bucket{routine=\"" << names[r] << "\",le=\"+Inf\"} " << flat[0] << std::endl;
+        out << "routine_latency_ns_sum" << label << " " << flat[3] << std::endl;
+        out << "routine_latency_ns_count" << label << " " << flat[0] << std::endl;
+    }
+
+    out << "# TYPE routine_latency_max_ns gauge" << std::endl;
+    for (size_t r = 0; r < names.size(); r++) {
+        out << "routine_latency_max_ns{routine=\"" << names[r] << "\"} " << merged[r][4] << std::endl;
+    }
+    return (bool)out;
+}
+
+#else
+
+#define INSTRUMENT_ROUTINE(name, bytesProcessed)
+
+static bool writeInstrumentationJson (const std::string&) { return false; }
+static bool writeInstrumentationPrometheus (const std::string&) { return false; }
+
+#endif // INSTRUMENT
+
+#endif // INSTRUMENTATION_H
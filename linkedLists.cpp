@@ -1,4 +1,8 @@
 #include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
 #include <vector>
 
 using namespace std;
@@ -48,6 +52,104 @@ Node* createListFromVector(vector<int> &values) {
     return head;
 }
 
+/*
+ * Binary format of a serialized list (same one LinkedList class uses):
+ *
+ *      uint32 magic | uint32 version | uint64 count | int32 values[count]
+ *
+ * Written in host byte order.
+ */
+static const uint32_t listFileMagic = 0x4C435443; // "CTCL"
+static const uint32_t listFileVersion = 1;
+
+/* Number of values serializeList()/deserializeList() write/read at once. */
+static const size_t listReadChunkSize = 1 << 16;
+
+void deleteList(Node *head) {
+    while (head != NULL) {
+        Node *tmp = head;
+        head = head->next;
+        delete tmp;
+    }
+}
+
+void serializeList(Node *head, ostream &out) {
+    uint64_t count = 0;
+    for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+        count++;
+    }
+
+    out.write((const char*)&listFileMagic, sizeof(listFileMagic));
+    out.write((const char*)&listFileVersion, sizeof(listFileVersion));
+    out.write((const char*)&count, sizeof(count));
+
+    // Values go out through a small buffer, so a big list isn't copied as a whole.
+    vector<int32_t> values;
+    values.reserve(min(count, (uint64_t)listReadChunkSize));
+    for (Node *currNode = head; currNode != NULL; currNode = currNode->next) {
+        values.push_back(currNode->value);
+        if (values.size() == listReadChunkSize || currNode->next == NULL) {
+            out.write((const char*)values.data(), values.size() * sizeof(int32_t));
+            values.clear();
+        }
+    }
+}
+
+/*
+ * Returns the head of the loaded list, or NULL if the stream doesn't hold a valid
+ * (non-empty) list.
+ */
+Node* deserializeList(istream &in) {
+    uint32_t magic = 0, version = 0;
+    uint64_t count = 0;
+    in.read((char*)&magic, sizeof(magic));
+    in.read((char*)&version, sizeof(version));
+    in.read((char*)&count, sizeof(count));
+    if (!in || magic != listFileMagic || version != listFileVersion) return NULL;
+
+    // NOTE: Count comes from the file, so values are read in bounded chunks instead of
+    // allocating for all of them up front - a short read means the file is broken.
+    vector<int32_t> values;
+    Node *head = NULL;
+    Node *tail = NULL;
+    for (uint64_t valuesLeft = count; valuesLeft > 0; ) {
+        size_t chunkCount = (size_t)min(valuesLeft, (uint64_t)listReadChunkSize);
+        values.resize(chunkCount);
+        in.read((char*)values.data(), chunkCount * sizeof(int32_t));
+        if (!in) {
+            deleteList(head);
+            return NULL;
+        }
+        valuesLeft -= chunkCount;
+
+        // NOTE: Keeping the tail around, appendToEnd() would make this O(n^2).
+        for (int32_t const &value : values) {
+            Node *newNode = new Node();
+            newNode->value = value;
+            newNode->next = NULL;
+
+            if (tail == NULL) {
+                head = newNode;
+            } else {
+                tail->next = newNode;
+            }
+            tail = newNode;
+        }
+    }
+    return head;
+}
+
+bool saveListToFile(Node *head, const string &path) {
+    ofstream out(path, ios::binary);
+    serializeList(head, out);
+    return (bool)out;
+}
+
+Node* loadListFromFile(const string &path) {
+    ifstream in(path, ios::binary);
+    return deserializeList(in);
+}
+
 /*
  * Problem 2.2
  * Find and return the k-th element from the end of a singly linked list.
@@ -100,5 +202,10 @@ int main() {
     Node *kthFromEnd = getKthFromEnd(head, 3);
     cout << "3rd from end: " << kthFromEnd->value << endl;
 
+    // Round trip through the binary format.
+    stringstream buffer;
+    serializeList(head, buffer);
+    printList(deserializeList(buffer));
+
     return 0;
 }